@@ -23,8 +23,12 @@
 // ----------------------------
 // Additional Libs
 // ----------------------------
+#include <vector>
+// Frame Speicher
 #include <ArduinoJson.h>
 // JSON Format
+#include <base64.h>
+// Base64 Kodierung für Basic Auth
 #include <PxMatrix.h>
 // Steuerung der Anzeige
 #include "webclient.h"
@@ -62,6 +66,9 @@ PxMATRIX display(matrix_width, matrix_height, P_LAT, P_OE, P_A, P_B, P_C, P_D, P
 // die Helligkeit der Anzeige, 30-70, je nach Bedarf anpassen
 uint8_t display_draw_time = 60;
 unsigned long scroll_speed = 50;  // Geschwindigkeit des Scrollens
+// Abstand der Refresh Interrupts in µs, die Anzeige ist gemultiplext und muss
+// auch bei unverändertem Inhalt ständig neu gezeichnet werden, sonst flimmert sie
+unsigned long display_refresh_interval = 4000;
 
 // ----------------------------------------
 // Timer für Callbacks
@@ -88,6 +95,34 @@ const char* www_username = "admin";      // Benutzername für Login, anzupassen
 const char* www_password = "esp32";      // Passwort für Login, anzupassen
 const char* hostname = "myesp32server";  // Die erreichbare Adresse des Servers
 WebServer server(80);                    // Server Port 80
+String www_auth_header;                  // vorberechneter Basic Auth Header, wird in setup() gesetzt
+
+// ----------------------------------------
+// Leerlauf & Statistik
+// ----------------------------------------
+unsigned long idle_poll_interval = 10;  // Pause in ms zwischen zwei Abfragen bei statischem Inhalt
+unsigned long stats_interval = 10000;   // Statistik alle 10 s auf Serial ausgeben
+
+// Schätzwerte für die Stromaufnahme des Boards ohne Anzeige, anzupassen
+#ifdef ESP32
+float current_active_mA = 120;  // CPU ausgelastet, WLAN verbunden
+float current_idle_mA = 45;     // CPU im Leerlauf, WLAN Modem Sleep
+#endif
+#ifdef ESP8266
+float current_active_mA = 80;  // CPU ausgelastet, WLAN verbunden
+float current_idle_mA = 20;    // CPU im Leerlauf, WLAN Modem Sleep
+#endif
+
+unsigned long stats_start = 0;                     // Beginn des Messfensters in µs
+unsigned long idle_micros = 0;                     // Leerlauf der Hauptschleife im Messfenster in µs
+unsigned long idle_refresh_micros = 0;             // davon im Refresh Interrupt verbracht in µs
+unsigned long idle_window_start = 0;               // Beginn des aktuellen Leerlauf-Fensters in µs
+unsigned long request_count = 0;                   // Anzahl der bearbeiteten Requests
+volatile unsigned long refresh_micros = 0;         // Zeit im Refresh Interrupt im Messfenster in µs
+volatile unsigned long refresh_window_micros = 0;  // Zeit im Refresh Interrupt im aktuellen Leerlauf-Fenster in µs
+float cpu_idle_percent = 0;                        // Leerlauf der CPU im letzten Messfenster
+float refresh_percent = 0;                         // Auslastung durch den Refresh im letzten Messfenster
+float current_estimate_mA = 0;                     // geschätzte Stromaufnahme im letzten Messfenster
 
 // ----------------------------
 // Hilfsvariablen
@@ -99,11 +134,38 @@ bool startTextLoop = false;  // scroll text als loop?
 String scroll_text = "";     // Text für scroll_text in loop()
 uint16_t text_color = 0;     // Farbe für scroll_text in loop()
 
-bool isGif = false;           // ist gif Endpunkt?
-bool startImageLoop = false;  // zeige Bilder in loop?
-JsonArray frames;             // Array der Bilder
-JsonArray delays;             // Array der Frame Delays
-uint16_t frameDelay;          // Frame Delay von movingimages Endpunkt
+bool startImageLoop = false;   // zeige Bilder in loop?
+uint32_t activeContentHash = 0;  // Hash des angezeigten Inhalts
+
+// ----------------------------------------
+// Frame Speicher
+// ----------------------------------------
+// jeder Frame wird über den Hash seines Inhalts identifiziert und nur einmal gespeichert,
+// auch wenn er in mehreren Inhalten oder mehrfach in einem GIF vorkommt
+struct StoredFrame {
+  uint32_t hash;
+  uint16_t width;
+  uint16_t height;
+  std::vector<uint16_t> pixels;  // leer = freier Platz im Speicher
+};
+
+// ein hochgeladener Inhalt (Bild, GIF oder mehrere Bilder) verweist über die
+// Frame Tabelle auf die Frames im Speicher
+struct StoredContent {
+  uint32_t hash;
+  std::vector<uint16_t> frameTable;  // Index im Frame Speicher je Frame
+  std::vector<uint32_t> delays;      // Delay je Frame in ms
+};
+
+const uint8_t maxStoredContents = 4;    // Max 4 Inhalte bleiben gespeichert, anzupassen
+const size_t frameHeapReserve = 16384;  // freier Heap, der für WLAN & Server bleiben soll
+
+const int FRAME_MISSING = -1;    // Frame nur als Hash gesendet, aber nicht gespeichert
+const int FRAME_NO_MEMORY = -2;  // kein Speicher für den Frame
+const int FRAME_INVALID = -3;    // Größe oder Hash passen nicht zu den Pixeln
+
+std::vector<StoredFrame> frameStore;      // alle gespeicherten Frames
+std::vector<StoredContent> contentStore;  // gespeicherte Inhalte, der älteste zuerst
 
 // ----------------------------------------
 // Funktionen für Anzeige Update
@@ -111,13 +173,21 @@ uint16_t frameDelay;          // Frame Delay von movingimages Endpunkt
 #ifdef ESP32
 void IRAM_ATTR display_updater() {
   portENTER_CRITICAL_ISR(&timerMux);
+  unsigned long start = micros();
   display.display(display_draw_time);
+  unsigned long elapsed = micros() - start;
+  refresh_micros += elapsed;
+  refresh_window_micros += elapsed;
   portEXIT_CRITICAL_ISR(&timerMux);
 }
 #endif
 #ifdef ESP8266
 void display_updater() {
+  unsigned long start = micros();
   display.display(display_draw_time);
+  unsigned long elapsed = micros() - start;
+  refresh_micros += elapsed;
+  refresh_window_micros += elapsed;
 }
 #endif
 
@@ -126,7 +196,7 @@ void display_update_enable(bool is_enable) {
   if (is_enable) {
     timer = timerBegin(0, 80, true);
     timerAttachInterrupt(timer, &display_updater, true);
-    timerAlarmWrite(timer, 4000, true);
+    timerAlarmWrite(timer, display_refresh_interval, true);
     timerAlarmEnable(timer);
   } else {
     timerDetachInterrupt(timer);
@@ -135,15 +205,309 @@ void display_update_enable(bool is_enable) {
 #endif
 #ifdef ESP8266
   if (is_enable)
-    display_ticker.attach(0.004, display_updater);
+    display_ticker.attach(display_refresh_interval / 1000000.0, display_updater);
   else
     display_ticker.detach();
 #endif
 }
 
+// ----------------------------------------
+// Funktionen für Leerlauf & Statistik
+// ----------------------------------------
+// liest einen vom Refresh Interrupt hochgezählten Wert und setzt ihn zurück,
+// ohne dass der Interrupt dazwischen kommt
+unsigned long takeRefreshMicros(volatile unsigned long& counter) {
+#ifdef ESP32
+  portENTER_CRITICAL(&timerMux);
+#endif
+#ifdef ESP8266
+  noInterrupts();
+#endif
+  unsigned long value = counter;
+  counter = 0;
+#ifdef ESP32
+  portEXIT_CRITICAL(&timerMux);
+#endif
+#ifdef ESP8266
+  interrupts();
+#endif
+  return value;
+}
+
+// ein Zeitabschnitt, der möglicherweise Leerlauf ist, beginnt
+void beginIdleWindow() {
+  takeRefreshMicros(refresh_window_micros);
+  idle_window_start = micros();
+}
+
+// der Zeitabschnitt endet, bei Leerlauf zählt er mit, abzüglich der Zeit,
+// die der Refresh Interrupt genau in diesem Abschnitt gelaufen ist
+void endIdleWindow(bool isIdle) {
+  unsigned long refresh = takeRefreshMicros(refresh_window_micros);
+  if (isIdle) {
+    idle_micros += micros() - idle_window_start;
+    idle_refresh_micros += refresh;
+  }
+}
+
+// wie delay(), die Zeit wird aber als Leerlauf gezählt
+void idleDelay(unsigned long ms) {
+  beginIdleWindow();
+  delay(ms);
+  endIdleWindow(true);
+}
+
+// server.handleClient(), ohne Request wartet der Server nur und die Zeit zählt als Leerlauf
+void handleClientIdle() {
+  unsigned long requests = request_count;
+  beginIdleWindow();
+  server.handleClient();
+  endIdleWindow(request_count == requests);
+}
+
+// wertet das Messfenster aus, sobald es abgelaufen ist
+void updateStats() {
+  unsigned long elapsed = micros() - stats_start;
+  if (elapsed < stats_interval * 1000) {
+    return;
+  }
+
+  unsigned long refresh = takeRefreshMicros(refresh_micros);
+  refresh_percent = 100.0 * refresh / elapsed;
+  // vom Leerlauf wird nur die Refresh Zeit abgezogen, die in die Leerlauf-Abschnitte fiel
+  cpu_idle_percent = idle_micros > idle_refresh_micros ? 100.0 * (idle_micros - idle_refresh_micros) / elapsed : 0;
+  current_estimate_mA = current_idle_mA + (current_active_mA - current_idle_mA) * (100 - cpu_idle_percent) / 100;
+
+  Serial.println("CPU Leerlauf: " + String(cpu_idle_percent, 1) + " %, Refresh: " + String(refresh_percent, 1) + " %, geschätzter Strom: " + String(current_estimate_mA, 0) + " mA");
+
+  idle_micros = 0;
+  idle_refresh_micros = 0;
+  stats_start = micros();
+}
+
+// ----------------------------------------
+// Funktionen für den Frame Speicher
+// ----------------------------------------
+// FNV-1a Hash, muss mit contentHash im WebClient übereinstimmen
+const uint32_t hashSeed = 2166136261u;
+
+uint32_t hashAdd16(uint32_t hash, uint16_t value) {
+  hash = (hash ^ (value & 0xFF)) * 16777619u;
+  return (hash ^ (value >> 8)) * 16777619u;
+}
+
+uint32_t hashAdd32(uint32_t hash, uint32_t value) {
+  return hashAdd16(hashAdd16(hash, value & 0xFFFF), value >> 16);
+}
+
+// Hash eines Inhalts aus den Hashes seiner Frames und den Delays
+uint32_t contentHash(const std::vector<uint16_t>& frameTable, const std::vector<uint32_t>& delays) {
+  uint32_t hash = hashSeed;
+  for (size_t i = 0; i < frameTable.size(); i++) {
+    hash = hashAdd32(hash, frameStore[frameTable[i]].hash);
+    hash = hashAdd32(hash, delays[i]);
+  }
+  return hash;
+}
+
+// größter freier Block im Heap
+size_t maxAllocBlock() {
+#ifdef ESP32
+  return ESP.getMaxAllocHeap();
+#endif
+#ifdef ESP8266
+  return ESP.getMaxFreeBlockSize();
+#endif
+}
+
+int findFrame(uint32_t hash) {
+  for (size_t i = 0; i < frameStore.size(); i++) {
+    if (frameStore[i].hash == hash && !frameStore[i].pixels.empty()) {
+      return i;
+    }
+  }
+  return FRAME_MISSING;
+}
+
+int findContent(uint32_t hash) {
+  for (size_t i = 0; i < contentStore.size(); i++) {
+    if (contentStore[i].hash == hash) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// gibt alle Frames frei, auf die kein gespeicherter Inhalt und keine
+// gerade entstehende Frame Tabelle mehr verweist
+void pruneFrames(const std::vector<uint16_t>& pendingTable) {
+  std::vector<bool> used(frameStore.size(), false);
+  for (const StoredContent& content : contentStore) {
+    for (uint16_t index : content.frameTable) {
+      used[index] = true;
+    }
+  }
+  for (uint16_t index : pendingTable) {
+    used[index] = true;
+  }
+
+  for (size_t i = 0; i < frameStore.size(); i++) {
+    if (!used[i] && !frameStore[i].pixels.empty()) {
+      frameStore[i].hash = 0;
+      std::vector<uint16_t>().swap(frameStore[i].pixels);
+    }
+  }
+}
+
+// verwirft den ältesten Inhalt und dessen nicht mehr verwendete Frames
+void evictOldestContent(const std::vector<uint16_t>& pendingTable) {
+  if (contentStore.front().hash == activeContentHash) {
+    startImageLoop = false;
+  }
+  contentStore.erase(contentStore.begin());
+  pruneFrames(pendingTable);
+}
+
+// speichert einen Frame aus dem Request, ein schon bekannter Frame wird nicht nochmal gespeichert
+// Frame Format: hash, size: [width, height], hexValues: [CCodeArray]
+// oder nur hash, wenn der Frame schon auf dem Server ist
+// gibt den Index im Frame Speicher oder einen FRAME_ Fehlercode zurück
+int storeFrame(JsonObject frame, const std::vector<uint16_t>& pendingTable) {
+  JsonArray values = frame["hexValues"].as<JsonArray>();
+  if (values.isNull()) {
+    // nur der Hash wurde gesendet
+    return findFrame(frame["hash"].as<uint32_t>());
+  }
+
+  JsonArray size = frame["size"].as<JsonArray>();
+  uint16_t width = size[0].as<uint16_t>();
+  uint16_t height = size[1].as<uint16_t>();
+  if (width == 0 || height == 0 || values.size() != (size_t)width * height) {
+    return FRAME_INVALID;
+  }
+
+  // Hash über die gesendeten Pixel berechnen und mit dem gesendeten Hash vergleichen
+  uint32_t hash = hashAdd16(hashAdd16(hashSeed, width), height);
+  for (JsonVariant value : values) {
+    hash = hashAdd16(hash, toPixel(value));
+  }
+  if (!frame["hash"].isNull() && frame["hash"].as<uint32_t>() != hash) {
+    return FRAME_INVALID;
+  }
+
+  int index = findFrame(hash);
+  if (index >= 0) {
+    // identischer Frame ist schon gespeichert
+    return index;
+  }
+
+  // Platz schaffen, notfalls alte Inhalte verwerfen
+  size_t bytes = values.size() * sizeof(uint16_t);
+  while (maxAllocBlock() < bytes + frameHeapReserve && !contentStore.empty()) {
+    evictOldestContent(pendingTable);
+  }
+  if (maxAllocBlock() < bytes + frameHeapReserve) {
+    return FRAME_NO_MEMORY;
+  }
+
+  // freien Platz im Frame Speicher wiederverwenden
+  for (index = 0; index < (int)frameStore.size(); index++) {
+    if (frameStore[index].pixels.empty()) {
+      break;
+    }
+  }
+  if (index == (int)frameStore.size()) {
+    frameStore.push_back(StoredFrame());
+  }
+
+  StoredFrame& stored = frameStore[index];
+  stored.hash = hash;
+  stored.width = width;
+  stored.height = height;
+  stored.pixels.reserve(values.size());
+  for (JsonVariant value : values) {
+    stored.pixels.push_back(toPixel(value));
+  }
+  return index;
+}
+
+// speichert alle Frames aus dem Request und ergänzt die Frame Tabelle
+// bei einem Fehler wird die HTTP Response gesendet und false zurückgegeben
+bool storeFrames(JsonArray frames, std::vector<uint16_t>& frameTable) {
+  for (JsonObject frame : frames) {
+    int index = storeFrame(frame, frameTable);
+    if (index < 0) {
+      // schon gespeicherte Frames dieses Requests gehören zu keinem Inhalt und werden freigegeben
+      pruneFrames({});
+      sendFrameError(index);
+      return false;
+    }
+    frameTable.push_back(index);
+  }
+  return true;
+}
+
+void sendFrameError(int error) {
+  switch (error) {
+    case FRAME_MISSING:
+      // der Client sendet den Inhalt dann komplett
+      server.send(409, "text/plain", "Frame fehlt");
+      Serial.println("Frame fehlt");
+      break;
+    case FRAME_NO_MEMORY:
+      server.send(413, "text/plain", "No Memory");
+      Serial.println("kein Memory");
+      break;
+    default:
+      server.send(400, "text/plain", "Frame Invalid");
+      Serial.println("Frame Invalid");
+      break;
+  }
+}
+
+// legt einen neuen Inhalt an, ein schon bekannter Inhalt wird nur wieder nach hinten gestellt
+uint32_t addContent(const std::vector<uint16_t>& frameTable, const std::vector<uint32_t>& delays) {
+  StoredContent content;
+  content.hash = contentHash(frameTable, delays);
+  content.frameTable = frameTable;
+  content.delays = delays;
+
+  int index = findContent(content.hash);
+  if (index >= 0) {
+    contentStore.erase(contentStore.begin() + index);
+  }
+  contentStore.push_back(content);
+
+  // nur die letzten Inhalte behalten
+  while (contentStore.size() > maxStoredContents) {
+    evictOldestContent(frameTable);
+  }
+  pruneFrames(frameTable);
+  return content.hash;
+}
+
+// zeigt einen gespeicherten Inhalt an, ein einzelnes Bild wird nur einmal gezeichnet
+void showContent(uint32_t hash) {
+  const StoredContent& content = contentStore[findContent(hash)];
+  activeContentHash = hash;
+  startTextLoop = false;
+  startImageLoop = content.frameTable.size() > 1;
+  if (!startImageLoop) {
+    drawFrame(content.frameTable[0]);
+  }
+}
+
 // ----------------------------
 // Event-Handler WebServer
 // ----------------------------
+// prüft den Authorization Header gegen den einmalig vorberechneten Wert,
+// damit die Zugangsdaten nicht bei jeder Request neu kodiert werden
+// jede Request außer 404 läuft hier durch und wird für die Statistik gezählt
+bool isAuthenticated() {
+  request_count++;
+  return server.header("Authorization").equalsConstantTime(www_auth_header);
+}
+
 // root endpoint, zeigt WebClient
 void handleRoot() {
   // sende die html Seite zum Client beim Aufruf des Servers
@@ -283,27 +647,29 @@ void handleImage() {
     }
 
     // Request Format
-    // hexValues: [SkaliertesBildAlsCCodeArray],
+    // hash: Hash des Bilds,
+    // hexValues: [SkaliertesBildAlsCCodeArray], als Zahlen oder Hex Strings
     // size: [imgWidth, imgHeight]
+    // hexValues und size fehlen, wenn das Bild schon gespeichert ist
 
+    // Platz des JSON Dokuments für den Frame Speicher freigeben
+    jsonDoc.shrinkToFit();
     JsonObject root = jsonDoc.as<JsonObject>();
-    JsonArray imgSize = root["size"].as<JsonArray>();
-    JsonArray imgValues = root["hexValues"].as<JsonArray>();
-    int valuesCount = imgValues.size();
 
-    // CCodeArray als uint16_t umwandeln
-    uint16_t sentImage[valuesCount];
-    for (int i = 0; i < valuesCount; i++) {
-      sentImage[i] = strtol(imgValues[i].as<String>().c_str(), NULL, 0);
+    std::vector<uint16_t> frameTable;
+    int index = storeFrame(root, frameTable);
+    if (index < 0) {
+      pruneFrames({});
+      sendFrameError(index);
+      return;
     }
+    frameTable.push_back(index);
 
     // sende Rückmeldung, dass das Bild verarbeitet wurde
     server.send(200, "text/plain", "Bild wurde erfolgreich verarbeitet!");
     Serial.println("Bild verarbeitet");
-    startTextLoop = false;
-    startImageLoop = false;
     // Bild anzeigen in der richtigen Größe
-    drawImage(sentImage, strtol(imgSize[0].as<String>().c_str(), NULL, 0), strtol(imgSize[1].as<String>().c_str(), NULL, 0));
+    showContent(addContent(frameTable, std::vector<uint32_t>(1, 0)));
   }
 }
 
@@ -357,17 +723,30 @@ void handleGif() {
 
     // Request Format
     // delays : [arrayOfDelays]
-    // frames : [size, hexValues]
+    // frames : [hash, size, hexValues], nur hash bei schon gespeicherten Frames
 
+    // Platz des JSON Dokuments für den Frame Speicher freigeben
+    jsonDoc.shrinkToFit();
     JsonObject root = jsonDoc.as<JsonObject>();
-    delays = root["delays"].as<JsonArray>();
-    frames = root["frames"].as<JsonArray>();
+    JsonArray frames = root["frames"].as<JsonArray>();
+    JsonArray delays = root["delays"].as<JsonArray>();
+    if (frames.size() == 0 || frames.size() != delays.size()) {
+      server.send(400, "text/plain", "Frames Invalid");
+      Serial.println("Frames Invalid");
+      return;
+    }
 
-    server.send(200, "text/plain", "Bild wurde erfolgreich verarbeitet!");
+    std::vector<uint16_t> frameTable;
+    if (!storeFrames(frames, frameTable)) {
+      return;
+    }
+    std::vector<uint32_t> frameDelays;
+    for (JsonVariant delay : delays) {
+      frameDelays.push_back(delay.as<uint32_t>());
+    }
 
-    isGif = true;
-    startTextLoop = false;
-    startImageLoop = true;
+    server.send(200, "text/plain", "Bild wurde erfolgreich verarbeitet!");
+    showContent(addContent(frameTable, frameDelays));
   }
 }
 
@@ -421,17 +800,161 @@ void handleMovingImg() {
 
     // Request Format
     // delay : delay value
-    // frames : [size, hexValues]    
+    // images : [hash, size, hexValues], nur hash bei schon gespeicherten Bildern
 
+    // Platz des JSON Dokuments für den Frame Speicher freigeben
+    jsonDoc.shrinkToFit();
     JsonObject root = jsonDoc.as<JsonObject>();
-    frameDelay = root["delay"].as<uint16_t>();
-    frames = root["images"].as<JsonArray>();
+    JsonArray frames = root["images"].as<JsonArray>();
+    if (frames.size() == 0) {
+      server.send(400, "text/plain", "Frames Invalid");
+      Serial.println("Frames Invalid");
+      return;
+    }
+
+    std::vector<uint16_t> frameTable;
+    if (!storeFrames(frames, frameTable)) {
+      return;
+    }
+    // gleiches Delay für alle Bilder
+    std::vector<uint32_t> frameDelays(frameTable.size(), root["delay"].as<uint32_t>());
 
     server.send(200, "text/plain", "Bild wurde erfolgreich verarbeitet!");
+    showContent(addContent(frameTable, frameDelays));
+  }
+}
+
+// /has endpoint, prüft welche Inhalte und Frames schon gespeichert sind
+void handleHas() {
+  if (server.method() != HTTP_POST) {
+    // keine gültige Methode, sende HTTP Response 405
+    server.send(405, "text/plain", "Method Not Allowed");
+  } else {
+    // ist eine POST Request, Hashes in JSON Format entgegennehmen
+    Serial.println("Hashes entgegengenommen");
+
+#ifdef ESP32
+    DynamicJsonDocument jsonDoc(ESP.getMaxAllocHeap());
+#endif
+#ifdef ESP8266
+    DynamicJsonDocument jsonDoc(ESP.getMaxFreeBlockSize() - 512);
+#endif
+    // Deserialization des Requests
+    DeserializationError error = deserializeJson(jsonDoc, server.arg("plain"));
 
-    isGif = false;
-    startTextLoop = false;
-    startImageLoop = true;
+    switch (error.code()) {
+      case DeserializationError::Ok:
+        Serial.println("Deserialization erfolgreich");
+        break;
+      case DeserializationError::EmptyInput:
+        server.send(400, "text/plain", "Empty Input");
+        Serial.println("Empty Input");
+        return;
+      case DeserializationError::IncompleteInput:
+        server.send(400, "text/plain", "Incomplete Input");
+        Serial.println("Incomplete Input");
+        return;
+      case DeserializationError::InvalidInput:
+        server.send(400, "text/plain", "JSON Invalid");
+        Serial.println("JSON Invalid");
+        return;
+      case DeserializationError::NoMemory:
+        server.send(413, "text/plain", "No Memory");
+        Serial.println("kein Memory");
+        return;
+      case DeserializationError::TooDeep:
+        server.send(413, "text/plain", "Too Deep");
+        Serial.println("Too Deep");
+        return;
+      default:
+        server.send(400, "text/plain", "Deserialization failed");
+        Serial.println("Deserialization Fehler");
+        return;
+    }
+
+    // Request Format
+    // content : Hash des kompletten Inhalts
+    // hashes : [arrayOfFrameHashes]
+
+    // Platz des JSON Dokuments für die Response freigeben
+    jsonDoc.shrinkToFit();
+    JsonObject root = jsonDoc.as<JsonObject>();
+    JsonArray hashes = root["hashes"].as<JsonArray>();
+
+    // Response Format
+    // content : true, wenn der Inhalt mit /activate angezeigt werden kann
+    // missing : [arrayOfFrameHashes], die noch gesendet werden müssen
+    DynamicJsonDocument response(JSON_OBJECT_SIZE(2) + JSON_ARRAY_SIZE(hashes.size()));
+    response["content"] = findContent(root["content"].as<uint32_t>()) >= 0;
+    JsonArray missing = response.createNestedArray("missing");
+    for (JsonVariant hash : hashes) {
+      if (findFrame(hash.as<uint32_t>()) < 0) {
+        missing.add(hash.as<uint32_t>());
+      }
+    }
+
+    String jsonString;
+    serializeJson(response, jsonString);
+    server.send(200, "application/json", jsonString);
+  }
+}
+
+// /activate endpoint, zeigt einen schon gespeicherten Inhalt wieder an
+void handleActivate() {
+  if (server.method() != HTTP_POST) {
+    // keine gültige Methode, sende HTTP Response 405
+    server.send(405, "text/plain", "Method Not Allowed");
+  } else {
+    // ist eine POST Request, Hash in JSON Format entgegennehmen
+    Serial.println("Aktivierung entgegengenommen");
+
+    StaticJsonDocument<64> jsonDoc;
+    // Deserialization des Requests
+    DeserializationError error = deserializeJson(jsonDoc, server.arg("plain"));
+
+    switch (error.code()) {
+      case DeserializationError::Ok:
+        Serial.println("Deserialization erfolgreich");
+        break;
+      case DeserializationError::EmptyInput:
+        server.send(400, "text/plain", "Empty Input");
+        Serial.println("Empty Input");
+        return;
+      case DeserializationError::IncompleteInput:
+        server.send(400, "text/plain", "Incomplete Input");
+        Serial.println("Incomplete Input");
+        return;
+      case DeserializationError::InvalidInput:
+        server.send(400, "text/plain", "JSON Invalid");
+        Serial.println("JSON Invalid");
+        return;
+      case DeserializationError::NoMemory:
+        server.send(413, "text/plain", "No Memory");
+        Serial.println("kein Memory");
+        return;
+      case DeserializationError::TooDeep:
+        server.send(413, "text/plain", "Too Deep");
+        Serial.println("Too Deep");
+        return;
+      default:
+        server.send(400, "text/plain", "Deserialization failed");
+        Serial.println("Deserialization Fehler");
+        return;
+    }
+
+    // Request Format
+    // content : Hash des kompletten Inhalts
+
+    uint32_t hash = jsonDoc["content"].as<uint32_t>();
+    if (findContent(hash) < 0) {
+      server.send(404, "text/plain", "Inhalt nicht gespeichert");
+      Serial.println("Inhalt nicht gespeichert");
+      return;
+    }
+
+    server.send(200, "text/plain", "Bild wurde erfolgreich verarbeitet!");
+    Serial.println("Gespeicherter Inhalt aktiviert");
+    showContent(hash);
   }
 }
 
@@ -455,8 +978,28 @@ void handleSize() {
   }
 }
 
+// /stats endpoint für GET Leerlauf & geschätzte Stromaufnahme
+void handleStats() {
+  if (server.method() != HTTP_GET) {
+    // keine gültige Methode, sende HTTP Response 405
+    server.send(405, "text/plain", "Method Not Allowed");
+    Serial.println("Method not allowed");
+  } else {
+    // ist eine GET Request, sende die Werte des letzten Messfensters an Client
+    // in der Format idle: %, refresh: %, current: mA
+    StaticJsonDocument<200> doc;
+    doc["idle"] = cpu_idle_percent;
+    doc["refresh"] = refresh_percent;
+    doc["current"] = current_estimate_mA;
+    String jsonString;
+    serializeJson(doc, jsonString);
+    server.send(200, "application/json", jsonString);
+  }
+}
+
 // keine gültige / bekannte endpoints
 void handleNotFound() {
+  request_count++;  // für die Statistik
   // sende 404 File Not Found
   String message = "File Not Found\n\n";
   message += "URI: ";
@@ -489,10 +1032,10 @@ void scrollText(String text, uint16_t colorRGB) {
     display.clearDisplay();      // immer Anzeige zurücksetzen, bevor etwas Neues angezeigt wird
     display.setCursor(xpos, 0);  // Setze den Text ganz oben (ypos=0), aber bei variablen xpos
     display.println(text);
-    delay(scroll_speed);
+    idleDelay(scroll_speed);
     yield();
 
-    delay(scroll_speed / 5);
+    idleDelay(scroll_speed / 5);
     yield();
   }
 }
@@ -508,6 +1051,20 @@ void drawText(String text, uint16_t colorRGB) {
   display.println(text);
 }
 
+// Pixelwert aus dem Request, als Zahl oder als Hex String "0x...."
+uint16_t toPixel(JsonVariant value) {
+  if (value.is<const char*>()) {
+    return strtol(value.as<const char*>(), NULL, 0);
+  }
+  return value.as<uint16_t>();
+}
+
+// zeige einen Frame aus dem Frame Speicher
+void drawFrame(uint16_t index) {
+  StoredFrame& frame = frameStore[index];
+  drawImage(frame.pixels.data(), frame.width, frame.height);
+}
+
 // zeige das skalierte Bild
 void drawImage(uint16_t image[], int imageWidth, int imageHeight) {
   display.clearDisplay();  // immer Anzeige zurücksetzen, bevor etwas Neues angezeigt wird
@@ -529,6 +1086,13 @@ void setup() {
   // WLAN Verbindung einstellen
   WiFi.setHostname(hostname);  // Setze den Namen des Servers
   WiFi.mode(WIFI_STA);
+  // WLAN Modem Sleep, damit das Funkmodul im Leerlauf zwischen den Beacons abschaltet
+#ifdef ESP32
+  WiFi.setSleep(true);
+#endif
+#ifdef ESP8266
+  WiFi.setSleepMode(WIFI_MODEM_SLEEP);
+#endif
   WiFi.begin(ssid, password);  // WLAN Verbindung aufbauen
   Serial.print("Verbinden mit ");
   Serial.println(ssid);
@@ -547,11 +1111,19 @@ void setup() {
   display.clearDisplay();  // immer Anzeige zurücksetzen, bevor etwas Neues angezeigt wird
   display_update_enable(true);
 
+  // Basic Auth Header einmalig berechnen
+#ifdef ESP32
+  www_auth_header = "Basic " + base64::encode(String(www_username) + ":" + www_password);
+#endif
+#ifdef ESP8266
+  www_auth_header = "Basic " + base64::encode(String(www_username) + ":" + www_password, false);
+#endif
+
   // handle alle Endpunkte
   // server handle root endpoint
   server.on("/", []() {
     // mit Authentifizierung für Login mit Benutzername und Password
-    if (!server.authenticate(www_username, www_password)) {
+    if (!isAuthenticated()) {
       return server.requestAuthentication();
     }
     // authentifizierte Nutzer dürfen die HTML Seite sehen
@@ -560,7 +1132,7 @@ void setup() {
 
   server.on("/text", []() {
     // mit Authentifizierung für Login mit Benutzername und Password
-    if (!server.authenticate(www_username, www_password)) {
+    if (!isAuthenticated()) {
       return server.requestAuthentication();
     }
     // server handle text endpoint
@@ -569,7 +1141,7 @@ void setup() {
 
   server.on("/image", []() {
     // mit Authentifizierung für Login mit Benutzername und Password
-    if (!server.authenticate(www_username, www_password)) {
+    if (!isAuthenticated()) {
       return server.requestAuthentication();
     }
     // server handle image endpoint
@@ -578,7 +1150,7 @@ void setup() {
 
   server.on("/size", []() {
     // mit Authentifizierung für Login mit Benutzername und Password
-    if (!server.authenticate(www_username, www_password)) {
+    if (!isAuthenticated()) {
       return server.requestAuthentication();
     }
     // server handle size endpoint
@@ -587,7 +1159,7 @@ void setup() {
 
   server.on("/gif", []() {
     // mit Authentifizierung für Login mit Benutzername und Password
-    if (!server.authenticate(www_username, www_password)) {
+    if (!isAuthenticated()) {
       return server.requestAuthentication();
     }
     // server handle gif endpoint
@@ -596,15 +1168,45 @@ void setup() {
 
   server.on("/movingimages", []() {
     // mit Authentifizierung für Login mit Benutzername und Password
-    if (!server.authenticate(www_username, www_password)) {
+    if (!isAuthenticated()) {
       return server.requestAuthentication();
     }
     // server handle movingimages endpoint
     handleMovingImg();
   });
 
+  server.on("/has", []() {
+    // mit Authentifizierung für Login mit Benutzername und Password
+    if (!isAuthenticated()) {
+      return server.requestAuthentication();
+    }
+    // server handle has endpoint
+    handleHas();
+  });
+
+  server.on("/activate", []() {
+    // mit Authentifizierung für Login mit Benutzername und Password
+    if (!isAuthenticated()) {
+      return server.requestAuthentication();
+    }
+    // server handle activate endpoint
+    handleActivate();
+  });
+
+  server.on("/stats", []() {
+    // mit Authentifizierung für Login mit Benutzername und Password
+    if (!isAuthenticated()) {
+      return server.requestAuthentication();
+    }
+    // server handle stats endpoint
+    handleStats();
+  });
+
   server.onNotFound(handleNotFound);  // server handle not found endpoint
-  server.begin();                     // Serverstart
+#ifdef ESP8266
+  server.keepAlive(true);  // Verbindung des Clients für weitere Requests offen halten
+#endif
+  server.begin();  // Serverstart
   Serial.println("Server started!");
 
   // zeige die Adresse des Servers auf der Anzeige in blau
@@ -614,13 +1216,15 @@ void setup() {
   display.setCursor(0, 0);
   display.setTextColor(display.color565(0, 0, 255));
   display.println(buffer);
+
+  stats_start = micros();  // erstes Messfenster der Statistik beginnt
 }
 
 // ---------------------------------------
 // Server handle Client in einer Schleife
 // ---------------------------------------
 void loop() {
-  server.handleClient();
+  handleClientIdle();
 
   if (startTextLoop) {
     // Lauftext in der ausgewählten Farbe
@@ -628,26 +1232,19 @@ void loop() {
   }
 
   if (startImageLoop) {
-    for (int j = 0; j < frames.size(); j++) {
-      JsonArray sizeArray = frames[j]["size"];
-      int width = strtol(sizeArray[0].as<String>().c_str(), NULL, 0);
-      int height = strtol(sizeArray[1].as<String>().c_str(), NULL, 0);
-
-      JsonArray image = frames[j]["hexValues"];
-      int valuesCount = image.size();
-      // CCodeArray als uint16_t umwandeln
-      uint16_t sentImage[valuesCount];
-      for (int i = 0; i < valuesCount; i++) {
-        sentImage[i] = strtol(image[i].as<String>().c_str(), NULL, 0);
-      }
-
-      drawImage(sentImage, width, height);
-
-      if (isGif) {
-        delay(delays[j]);
-      } else {
-        delay(frameDelay);
-      }
+    // Frames des angezeigten Inhalts aus dem Frame Speicher anzeigen
+    const StoredContent& content = contentStore[findContent(activeContentHash)];
+    for (size_t j = 0; j < content.frameTable.size(); j++) {
+      drawFrame(content.frameTable[j]);
+      idleDelay(content.delays[j]);
     }
   }
+
+  if (!startTextLoop && !startImageLoop) {
+    // statischer Inhalt, nichts zu animieren
+    // statt busy-wait bis zur nächsten Abfrage pausieren, damit die CPU in den Leerlauf gehen kann
+    idleDelay(idle_poll_interval);
+  }
+
+  updateStats();
 }
\ No newline at end of file
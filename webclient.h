@@ -218,7 +218,167 @@ const char htmlPage[] = R"=====(
     <button type="reset" id="txtSendButton" disabled>Hochladen</button>
   </form>
 
-  <script src="https://cdn.jsdelivr.net/npm/omggif@1.0.10/omggif.min.js"></script>
+  <script id="converterShared">
+    // gemeinsame Funktionen für die Bildumwandlung
+    // dieses Skript läuft auf der Seite und wird auch in den Worker übernommen
+    const omggifUrl = 'https://cdn.jsdelivr.net/npm/omggif@1.0.10/omggif.min.js';
+
+    // FNV-1a Hash für Frames und Inhalte, muss mit der Berechnung im Server übereinstimmen
+    const hashSeed = 2166136261;
+
+    function hashAdd16(hash, value) {
+      hash = Math.imul(hash ^ (value & 0xFF), 16777619) >>> 0;
+      return Math.imul(hash ^ ((value >>> 8) & 0xFF), 16777619) >>> 0;
+    }
+
+    function hashAdd32(hash, value) {
+      return hashAdd16(hashAdd16(hash, value & 0xFFFF), value >>> 16);
+    }
+
+    function frameHash(width, height, pixels) {
+      // Hash eines Frames aus seiner Größe und allen Pixeln
+      let hash = hashAdd16(hashAdd16(hashSeed, width), height);
+      for (let i = 0; i < pixels.length; i++)
+        hash = hashAdd16(hash, pixels[i]);
+      return hash;
+    }
+
+    function contentHash(frames, delays) {
+      // Hash eines kompletten Inhalts aus den Hashes seiner Frames und den Delays
+      let hash = hashSeed;
+      for (let i = 0; i < frames.length; i++) {
+        hash = hashAdd32(hash, frames[i].hash);
+        hash = hashAdd32(hash, delays[i]);
+      }
+      return hash;
+    }
+
+    function decodeGifFrames(gifData, onFrame) {
+      // dekodiert alle Frames in einen gemeinsamen Puffer, damit Frames, die nur
+      // einen Teil des Bilds ändern, auf dem vorherigen Frame aufbauen
+      // jeder Frame wird als eigene Kopie an onFrame übergeben
+      const gifReader = new GifReader(new Uint8Array(gifData));
+      const width = gifReader.width;
+      const height = gifReader.height;
+      const rgba = new Uint8ClampedArray(width * height * 4);
+
+      for (let i = 0; i < gifReader.numFrames(); i++) {
+        const frameInfo = gifReader.frameInfo(i);
+        gifReader.decodeAndBlitFrameRGBA(i, rgba);
+
+        onFrame({
+          index: i,
+          delay: frameInfo.delay * 10,
+          width: width,
+          height: height,
+          rgba: rgba.slice()
+        });
+
+        if (frameInfo.disposal == 2) {
+          // Bereich des Frames für den nächsten Frame wieder löschen
+          for (let y = frameInfo.y; y < frameInfo.y + frameInfo.height; y++) {
+            rgba.fill(0, (y * width + frameInfo.x) * 4, (y * width + frameInfo.x + frameInfo.width) * 4);
+          }
+        }
+      }
+    }
+
+    function convertRgba(frameCanvas, scaleCanvas, job) {
+      // ein dekodierter GIF Frame in ein C Code Array
+      frameCanvas.width = job.width;
+      frameCanvas.height = job.height;
+      frameCanvas.getContext('2d').putImageData(new ImageData(new Uint8ClampedArray(job.rgba.buffer), job.width, job.height), 0, 0);
+      return convertImage(scaleCanvas, frameCanvas, job.width, job.height, job.displayWidth, job.displayHeight);
+    }
+
+    function convertImage(scaleCanvas, image, imageWidth, imageHeight, displayWidth, displayHeight) {
+      // Bild skalieren wenn nötig
+      let width = imageWidth;
+      let height = imageHeight;
+      if (imageWidth > displayWidth || imageHeight > displayHeight) {
+        let scale = Math.min(displayWidth / imageWidth, displayHeight / imageHeight);
+
+        width = Math.floor(imageWidth * scale);
+        height = Math.floor(imageHeight * scale);
+      }
+
+      // Bild für die LED-Anzeige verarbeiten
+      scaleCanvas.width = width;
+      scaleCanvas.height = height;
+      let context = scaleCanvas.getContext('2d');
+      context.clearRect(0, 0, width, height);
+      context.drawImage(image, 0, 0, width, height);
+      let pixelData = context.getImageData(0, 0, width, height).data;
+
+      // pixel data berechnen für das C Code Array
+      const pixels = new Uint16Array(width * height);
+      for (let i = 0, p = 0; p < pixels.length; i += 4, p++) {
+        let r = pixelData[i];
+        let g = pixelData[i + 1];
+        let b = pixelData[i + 2];
+
+        pixels[p] = ((r & 0x1F) << 11) | ((g & 0x3F) << 5) | (b & 0x1F);
+      }
+
+      // C Code Array mit Größe und Hash
+      return {
+        size: [width, height],
+        hash: frameHash(width, height, pixels),
+        pixels: pixels
+      };
+    }
+  </script>
+  <script type="text/js-worker" id="converterWorker">
+    // Web Worker für die Bildumwandlung, läuft außerhalb des Main Threads
+
+    // Canvas werden pro Worker nur einmal beim ersten Auftrag angelegt und wiederverwendet
+    // so landet ein Browser ohne OffscreenCanvas als Fehler beim Auftrag
+    let scaleCanvas = null;
+    let frameCanvas = null;
+
+    self.onmessage = async (e) => {
+      const job = e.data;
+      try {
+        if (!scaleCanvas) {
+          scaleCanvas = new OffscreenCanvas(1, 1);
+          frameCanvas = new OffscreenCanvas(1, 1);
+        }
+
+        if (job.type === 'decodeGif') {
+          // omggif wird erst für das erste GIF geladen, damit andere Bilder auch ohne Internet funktionieren
+          if (typeof GifReader === 'undefined')
+            importScripts(omggifUrl);
+
+          // jeder Frame wird ohne weitere Kopie an den Main Thread übergeben
+          decodeGifFrames(job.gifData, (frame) => {
+            frame.type = 'frame';
+            frame.id = job.id;
+            self.postMessage(frame, [frame.rgba.buffer]);
+          });
+          self.postMessage({ type: 'done', id: job.id });
+        }
+        else if (job.type === 'convertRgba') {
+          postConverted(job, convertRgba(frameCanvas, scaleCanvas, job));
+        }
+        else {
+          // eine Bilddatei
+          const bitmap = await createImageBitmap(job.file);
+          postConverted(job, convertImage(scaleCanvas, bitmap, bitmap.width, bitmap.height, job.displayWidth, job.displayHeight));
+          bitmap.close();
+        }
+      }
+      catch (error) {
+        self.postMessage({ type: 'error', id: job.id, error: String(error) });
+      }
+    };
+
+    function postConverted(job, converted) {
+      // C Code Array mit Hash ohne Kopie an den Main Thread übergeben
+      converted.type = 'converted';
+      converted.id = job.id;
+      self.postMessage(converted, [converted.pixels.buffer]);
+    }
+  </script>
   <script>
     //#region Globale Hilfsvariablen
     const maxImages = 3;   // Max 3 Bildern hochladen
@@ -233,13 +393,23 @@ const char htmlPage[] = R"=====(
     var isValidMode = false;  // Flag Textmodus valid
 
     var uploadedImages = []; // Array der eingegebenen Bilder
+
+    var requestQueue = Promise.resolve(); // Warteschlange, damit alle Requests nacheinander über dieselbe Verbindung laufen
+
+    const maxConverterWorkers = 4;       // Max 4 Worker für die Bildumwandlung
+    var converterPool = [];              // Worker für die Bildumwandlung
+    var converterQueue = [];             // Aufträge, die auf einen freien Worker warten
+    var pendingConverterJobs = new Map(); // laufende Aufträge an die Worker
+    var nextConverterJobId = 0;          // ID des nächsten Auftrags
+    var converterWorkersSupported = null; // Worker im Browser nutzbar? null = noch nicht geprüft
+    var pageCanvases = null;             // Canvas für die Umwandlung ohne Worker
     //#endregion
 
     function onPageLoad() {
       // Beim Laden der Seite wird eine GET SIZE Request gesendet
       // der Server schickt dann als Response die Größe der LED-Anzeige zurück
       // Bei einem Fehler wird der Nutzer benachrichtigt
-      fetch('./size')
+      enqueueRequest(() => fetch('./size'))
         .then(response => response.json())
         .then(data => {
           displayWidth = data.size[0];
@@ -377,24 +547,17 @@ const char htmlPage[] = R"=====(
         // es gibt mehrere Bilder, das C Code Array von den Bildern mit der Größe und Delay in JSON Format wird als HTTP POST Request an API endpoint /movingimages gesendet
         // Bei einer Response wird diese als Meldung angezeigt, danach wird die Seite zurückgesetzt
         processImages()
-          .then((imagesWithDelay) => {
-            console.log(JSON.stringify(imagesWithDelay));
-            fetch('./movingimages', {
-              method: 'POST',
-              headers: {
-                "Content-Type": "application/json"
-              },
-              body: JSON.stringify(imagesWithDelay)
-            })
-              .then(response => response.text())
-              .then(data => {
-                alert(data);
-                resetImages();
-              })
-              .catch(error => {
-                alert('Error: ', error);
-                resetImages();
-              });
+          .then(imagesWithDelay => uploadContent('./movingimages',
+            imagesWithDelay.images,
+            imagesWithDelay.images.map(() => imagesWithDelay.delay),
+            (images) => ({ delay: imagesWithDelay.delay, images: images })))
+          .then(data => {
+            alert(data);
+            resetImages();
+          })
+          .catch(error => {
+            alert('Error: ' + error);
+            resetImages();
           });
       }
       else {
@@ -402,55 +565,32 @@ const char htmlPage[] = R"=====(
           // es gibt nur ein Bild als .gif Format, das C Code Array vom Bild mit der Größe in JSON Format wird als HTTP POST Request an API endpoint /gif gesendet
           // Bei einer Response wird diese als Meldung angezeigt, danach wird die Seite zurückgesetzt
           processGif()
-            .then(framesWithDelay => {
-              console.log(JSON.stringify(framesWithDelay));
-              fetch('./gif', {
-                method: 'POST',
-                headers: {
-                  "Content-Type": "application/json"
-                },
-                body: JSON.stringify(framesWithDelay)
-              })
-                .then(response => response.text())
-                .then(data => {
-                  alert(data);
-                  resetImages();
-                })
-                .catch(error => {
-                  alert('Error: ', error);
-                  resetImages();
-                });
+            .then(framesWithDelay => uploadContent('./gif',
+              framesWithDelay.frames,
+              framesWithDelay.delays,
+              (frames) => ({ delays: framesWithDelay.delays, frames: frames })))
+            .then(data => {
+              alert(data);
+              resetImages();
             })
             .catch(error => {
-              alert('Error: ', error);
-            })
+              alert('Error: ' + error);
+              resetImages();
+            });
         }
         else {
           // es gibt nur ein Bild, das C Code Array vom Bild mit der Größe in JSON Format wird als HTTP POST Request an API endpoint /image gesendet
           // Bei einer Response wird diese als Meldung angezeigt, danach wird die Seite zurückgesetzt
           processImg(uploadedImages[0])
-            .then(cCodeWithSize => {
-              console.log(JSON.stringify(cCodeWithSize));
-              fetch('./image', {
-                method: 'POST',
-                headers: {
-                  "Content-Type": "application/json"
-                },
-                body: JSON.stringify(cCodeWithSize)
-              })
-                .then(response => response.text())
-                .then(data => {
-                  alert(data);
-                  resetImages();
-                })
-                .catch(error => {
-                  alert('Error: ', error);
-                  resetImages();
-                });
+            .then(cCodeWithSize => uploadContent('./image', [cCodeWithSize], [0], (images) => images[0]))
+            .then(data => {
+              alert(data);
+              resetImages();
             })
             .catch(error => {
-              alert('Error: ', error);
-            })
+              alert('Error: ' + error);
+              resetImages();
+            });
         }
       }
     }
@@ -470,14 +610,7 @@ const char htmlPage[] = R"=====(
 
       console.log(JSON.stringify(textSetup));
 
-      fetch('./text', {
-        method: 'POST',
-        headers: {
-          'Content-Type': 'application/json; charset=utf-8'
-        },
-        body: JSON.stringify(textSetup)
-      })
-        .then(response => response.text())
+      postJson('./text', textSetup)
         .then(data => {
           alert(data);
         })
@@ -492,6 +625,31 @@ const char htmlPage[] = R"=====(
     //#endregion
 
     //#region helfende Funktionen
+    function enqueueRequest(sendRequest) {
+      // Requests werden nicht parallel, sondern direkt hintereinander gesendet
+      // so nutzt der Browser eine einzige Keep-Alive Verbindung zum Server
+      // statt für jede Request eine neue TCP Verbindung aufzubauen
+      const request = requestQueue.then(sendRequest);
+      requestQueue = request.catch(() => { });
+      return request;
+    }
+
+    function sendJson(endpoint, payload) {
+      // sendet die Daten in JSON Format als HTTP POST Request über die Warteschlange
+      return enqueueRequest(() => fetch(endpoint, {
+        method: 'POST',
+        headers: {
+          'Content-Type': 'application/json; charset=utf-8'
+        },
+        body: JSON.stringify(payload)
+      }));
+    }
+
+    function postJson(endpoint, payload) {
+      // wie sendJson, liefert aber den Text der Response zurück
+      return sendJson(endpoint, payload).then(response => response.text());
+    }
+
     function loadImage(files) {
       // Bei einer Bildeingabe mit mehr als x Bildern ist es nicht zulässig
       if (uploadedImages.length + files.length > maxImages) {
@@ -598,115 +756,256 @@ const char htmlPage[] = R"=====(
 
     async function processImages() {
       // Bilder und Delay in JSON Format vorbereiten
-      const imagesWithDelay = {
-        delay: transitionTimeField.value,
-        images: []
+      // alle Bilder werden gleichzeitig in den Workern umgewandelt
+      const images = await Promise.all(uploadedImages.map(file => processImg(file)));
+
+      return {
+        delay: parseInt(transitionTimeField.value),
+        images: images
       };
+    }
+
+    async function processGif() {
+      // GIF Frames und Delay in JSON Format vorbereiten
+      // ein Worker dekodiert die Frames nacheinander, jeder fertige Frame wird sofort
+      // ohne Kopie an den nächsten Worker zur Umwandlung in ein C Code Array weitergereicht
+      const gifData = await uploadedImages[0].arrayBuffer();
+      const delays = [];
+      const conversions = [];
+
+      await runConverterJob({ type: 'decodeGif', gifData: gifData }, [gifData], (frame) => {
+        delays[frame.index] = frame.delay;
+        conversions[frame.index] = runConverterJob({
+          type: 'convertRgba',
+          rgba: frame.rgba,
+          width: frame.width,
+          height: frame.height
+        }, [frame.rgba.buffer]);
+      });
+
+      const frames = await Promise.all(conversions);
+      return {
+        delays: delays,
+        frames: frames
+      };
+    }
+
+    function processImg(file) {
+      // konvertiert das Bild in einem Worker in ein C Code Array mit Größe und Hash
+      return runConverterJob({ type: 'convertFile', file: file });
+    }
+
+    async function uploadContent(endpoint, frames, delays, buildPayload) {
+      // fragt zuerst nach, was der Server schon gespeichert hat
+      // ein bekannter Inhalt wird nur aktiviert, sonst werden nur die fehlenden Frames komplett gesendet
+      const content = contentHash(frames, delays);
+      const hashes = [...new Set(frames.map(frame => frame.hash))];
+      // die Abfrage spart nur Daten, bei jedem Fehler wird der Inhalt komplett gesendet
+      let stored;
+      try {
+        const response = await sendJson('./has', { content: content, hashes: hashes });
+        if (!response.ok)
+          return sendFullContent(endpoint, frames, hashes, buildPayload);
+        stored = await response.json();
+        if (!stored || !Array.isArray(stored.missing))
+          return sendFullContent(endpoint, frames, hashes, buildPayload);
+      }
+      catch (error) {
+        return sendFullContent(endpoint, frames, hashes, buildPayload);
+      }
+
+      if (stored.content) {
+        const activated = await sendJson('./activate', { content: content });
+        if (activated.ok)
+          return activated.text();
+        // der Server hat den Inhalt inzwischen verworfen, alle Frames komplett senden
+        return sendFullContent(endpoint, frames, hashes, buildPayload);
+      }
+
+      const response = await sendJson(endpoint, buildPayload(toJsonFrames(frames, new Set(stored.missing))));
+      if (response.status == 409) {
+        // der Server hat inzwischen Frames verworfen, alle Frames komplett senden
+        return sendFullContent(endpoint, frames, hashes, buildPayload);
+      }
+      return response.text();
+    }
+
+    function sendFullContent(endpoint, frames, hashes, buildPayload) {
+      // sendet jeden Frame komplett, unabhängig davon, was der Server laut /has gespeichert hat
+      return postJson(endpoint, buildPayload(toJsonFrames(frames, new Set(hashes))));
+    }
+
+    function toJsonFrames(frames, missing) {
+      // Frames für den Request in JSON Format vorbereiten
+      // jeder fehlende Frame wird nur beim ersten Auftreten mit Größe und C Code Array gesendet,
+      // von allen anderen Frames reicht der Hash
+      return frames.map(frame => {
+        if (!missing.has(frame.hash))
+          return { hash: frame.hash };
+
+        missing.delete(frame.hash);
+        return {
+          hash: frame.hash,
+          size: frame.size,
+          hexValues: Array.from(frame.pixels)
+        };
+      });
+    }
+
+    function createConverterPool() {
+      // Worker für die Bildumwandlung anlegen, damit die Seite währenddessen bedienbar bleibt
+      const workerSource = [
+        document.getElementById('converterShared').textContent,
+        document.getElementById('converterWorker').textContent
+      ];
+      const workerUrl = URL.createObjectURL(new Blob(workerSource, { type: 'text/javascript' }));
+      const poolSize = Math.max(1, Math.min(navigator.hardwareConcurrency || 2, maxConverterWorkers));
+
+      for (let i = 0; i < poolSize; i++) {
+        const worker = new Worker(workerUrl);
+        worker.busy = false;
+        worker.onmessage = (e) => handleConverterMessage(e.data);
+        worker.onerror = (e) => failConverterPool(e.message || 'Worker Fehler');
+        worker.onmessageerror = () => failConverterPool('Worker Nachricht fehlerhaft');
+        converterPool.push(worker);
+      }
+    }
+
+    function failConverterPool(error) {
+      // ein Worker ist ausgefallen, alle laufenden Aufträge abbrechen
+      // der nächste Auftrag legt die Worker dann neu an
+      converterPool.forEach(worker => worker.terminate());
+      converterPool = [];
+      pendingConverterJobs.forEach(job => job.reject(error));
+      pendingConverterJobs.clear();
+      converterQueue.forEach(job => job.reject(error));
+      converterQueue = [];
+    }
 
-      for (let i = 0; i < uploadedImages.length; i++) {
+    function supportsConverterWorkers() {
+      // Worker brauchen Worker und OffscreenCanvas mit 2D Context
+      // (fehlt z.B. bei Safari vor 16.4 und Firefox vor 105), wird nur einmal geprüft
+      if (converterWorkersSupported === null) {
         try {
-          // jedes Bild in C Code Array umwandeln
-          const cCodeSize = await processImg(uploadedImages[i]);
-          imagesWithDelay.images.push(cCodeSize);
+          converterWorkersSupported = typeof Worker !== 'undefined' && typeof OffscreenCanvas !== 'undefined'
+            && new OffscreenCanvas(1, 1).getContext('2d') != null;
         }
         catch (error) {
-          alert('Error: ' + error);
+          converterWorkersSupported = false;
         }
       }
-
-      return imagesWithDelay;
+      return converterWorkersSupported;
     }
 
-    function processGif() {
-      // GIF Frames und Delay in JSON Format vorbereiten
-      const framesWithDelay = {
-        delays: [],
-        frames: []
-      };
+    function runConverterJob(job, transfer, onFrame) {
+      // stellt einen Auftrag für den nächsten freien Worker in die Warteschlange, transfer enthält
+      // die Puffer, die ohne Kopie an den Worker übergeben werden
+      job.displayWidth = displayWidth;
+      job.displayHeight = displayHeight;
+      if (!supportsConverterWorkers())
+        return runConverterJobOnPage(job, onFrame);
+
+      if (converterPool.length == 0)
+        createConverterPool();
 
-      // Gif laden und konvertiert jede Frames in C Code Array sowie stellt Delays zwischen den Frames fest
       return new Promise((resolve, reject) => {
-        // konvertiert das Bild in ein C Code Array
-        const reader = new FileReader();
-        reader.onload = async function (e) {
-          const gifData = new Uint8Array(e.target.result);
-          const gifReader = new GifReader(gifData);
-
-          for (let i = 0; i < gifReader.numFrames(); i++) {
-            const frameInfo = gifReader.frameInfo(i);
-            framesWithDelay.delays.push(frameInfo.delay * 10);
-
-            const image = new ImageData(frameInfo.width, frameInfo.height);
-            gifReader.decodeAndBlitFrameRGBA(i, image.data);
-
-            let canvas = document.createElement('canvas');
-            canvas.width = frameInfo.width;
-            canvas.height = frameInfo.height;
-            canvas.getContext('2d').putImageData(image, 0, 0);
-
-            const cCodeSize = convertImgToCCodeSize(canvas);
-            framesWithDelay.frames.push(cCodeSize);
-          }
+        job.id = nextConverterJobId++;
+        converterQueue.push({ job: job, transfer: transfer || [], resolve: resolve, reject: reject, onFrame: onFrame });
+        dispatchConverterJobs();
+      });
+    }
 
-          resolve(framesWithDelay);
+    async function runConverterJobOnPage(job, onFrame) {
+      // Umwandlung ohne Worker auf der Seite mit normalen <canvas> Elementen
+      // liefert das gleiche Ergebnis wie ein Worker
+      if (!pageCanvases) {
+        pageCanvases = {
+          scale: document.createElement('canvas'),
+          frame: document.createElement('canvas')
         };
-        reader.readAsArrayBuffer(uploadedImages[0]);
-        reader.onerror = (error) => reject(error);
+      }
+
+      if (job.type === 'decodeGif') {
+        await loadGifReader();
+        decodeGifFrames(job.gifData, onFrame);
+        return { type: 'done' };
+      }
+      if (job.type === 'convertRgba')
+        return convertRgba(pageCanvases.frame, pageCanvases.scale, job);
+
+      const image = await loadImageElement(job.file);
+      return convertImage(pageCanvases.scale, image, image.width, image.height, job.displayWidth, job.displayHeight);
+    }
+
+    function loadGifReader() {
+      // omggif erst für das erste GIF auf der Seite laden
+      if (typeof GifReader !== 'undefined')
+        return Promise.resolve();
+
+      return new Promise((resolve, reject) => {
+        const script = document.createElement('script');
+        script.src = omggifUrl;
+        script.onload = () => resolve();
+        script.onerror = () => reject('omggif konnte nicht geladen werden');
+        document.head.appendChild(script);
       });
     }
 
-    function processImg(file) {
+    function loadImageElement(file) {
+      // lädt eine Bilddatei in ein <img> Element
       return new Promise((resolve, reject) => {
-        // konvertiert das Bild in ein C Code Array
-        const reader = new FileReader();
-        reader.readAsDataURL(file);
-        reader.onload = function () {
-          let image = new Image();
-          image.src = reader.result;
-          image.onload = (e) => resolve(convertImgToCCodeSize(e.target));
+        const url = URL.createObjectURL(file);
+        const image = new Image();
+        image.onload = () => {
+          URL.revokeObjectURL(url);
+          resolve(image);
         };
-        reader.onerror = (error) => reject(error);
+        image.onerror = () => {
+          URL.revokeObjectURL(url);
+          reject('Bild konnte nicht geladen werden');
+        };
+        image.src = url;
       });
     }
 
-    function convertImgToCCodeSize(image) {
-      let canvas = document.createElement('canvas');
-      // Bild skalieren wenn nötig
-      if (image.width > displayWidth || image.height > displayHeight) {
-        let scale = Math.min(displayWidth / image.width, displayHeight / image.height);
-
-        canvas.width = image.width * scale;
-        canvas.height = image.height * scale;
-      }
-      else {
-        canvas.width = image.width;
-        canvas.height = image.height;
+    function dispatchConverterJobs() {
+      // jeder wartende Auftrag geht an den ersten freien Worker
+      // so landen die Frames eines GIFs nicht auf dem Worker, der das GIF noch dekodiert
+      for (const worker of converterPool) {
+        if (converterQueue.length == 0)
+          return;
+        if (worker.busy)
+          continue;
+
+        const job = converterQueue.shift();
+        job.worker = worker;
+        worker.busy = true;
+        pendingConverterJobs.set(job.job.id, job);
+        worker.postMessage(job.job, job.transfer);
       }
+    }
 
-      // Bild für die LED-Anzeige verarbeiten
-      let context = canvas.getContext('2d');
-      context.drawImage(image, 0, 0, canvas.width, canvas.height);
-
-      let imageData = context.getImageData(0, 0, canvas.width, canvas.height);
-      let pixelData = imageData.data;
-
-      // pixel data berechnen für das C Code Array, es wird mit der Größe des Bilds in JSON Format vorbereitet 
-      const cCodeSize = {
-        size: [canvas.width, canvas.height],
-        hexValues: []
-      };
-
-      for (var i = 0; i < pixelData.length; i += 4) {
-        let r = pixelData[i];
-        let g = pixelData[i + 1];
-        let b = pixelData[i + 2];
+    function handleConverterMessage(result) {
+      // Antwort eines Workers dem passenden Auftrag zuordnen
+      const job = pendingConverterJobs.get(result.id);
+      if (!job)
+        return;
 
-        let uint16Value = ((r & 0x1F) << 11) | ((g & 0x3F) << 5) | (b & 0x1F);
-        let hexValue = uint16Value.toString(16).toUpperCase().padStart(4, '0');
-        cCodeSize.hexValues.push('0x' + hexValue);
+      if (result.type === 'frame') {
+        // ein dekodierter GIF Frame, der Auftrag läuft noch weiter
+        job.onFrame(result);
+        return;
       }
 
-      return cCodeSize;
+      pendingConverterJobs.delete(result.id);
+      job.worker.busy = false;
+      if (result.type === 'error')
+        job.reject(result.error);
+      else
+        job.resolve(result);
+
+      // der Worker ist wieder frei für den nächsten Auftrag
+      dispatchConverterJobs();
     }
 
     function hexToRGB(hexValue) {